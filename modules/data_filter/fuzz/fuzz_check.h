@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Property violations abort so libFuzzer, AFL++ and the replay driver all
+// record the input as a crash.
+#define FUZZ_CHECK(cond, what)                                              \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "FUZZ_CHECK failed: %s (%s:%d)\n", what,   \
+                         __FILE__, __LINE__);                               \
+            std::abort();                                                   \
+        }                                                                   \
+    } while (0)
+
+namespace iot_edge::fuzz {
+
+/// Numbers are serialized with fixed precision, so a round trip may move a
+/// value by half a unit in the last printed digit (plus float rounding).
+inline bool close_enough(double a, double b, double half_unit) {
+    if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b);
+    if (std::isinf(a) || std::isinf(b)) return a == b;
+    double tol = half_unit * 1.01 + std::fabs(a) * 1e-12;
+    return std::fabs(a - b) <= tol;
+}
+
+}  // namespace iot_edge::fuzz
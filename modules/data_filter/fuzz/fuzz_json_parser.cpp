@@ -0,0 +1,32 @@
+// Fuzz target for JsonParser::parse_sensor_message.
+//
+// Any input must parse or be rejected without crashing. When it parses, the
+// differential check re-serializes with JsonParser::to_json and requires the
+// second parse to agree with the first.
+
+#include "json_parser.h"
+#include "fuzz_check.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    using iot_edge::JsonParser;
+    using iot_edge::fuzz::close_enough;
+
+    std::string input(reinterpret_cast<const char*>(data), size);
+    auto first = JsonParser::parse_sensor_message(input);
+    if (!first) return 0;
+
+    std::string json = JsonParser::to_json(*first, true);
+    auto second = JsonParser::parse_sensor_message(json);
+
+    FUZZ_CHECK(second.has_value(), "to_json output does not parse");
+    FUZZ_CHECK(second->sensor_id == first->sensor_id, "sensorId changed");
+    FUZZ_CHECK(second->timestamp == first->timestamp, "timestamp changed");
+    FUZZ_CHECK(second->sequence_number == first->sequence_number, "sequenceNumber changed");
+    FUZZ_CHECK(close_enough(second->temperature, first->temperature, 0.005), "temperature drifted");
+    FUZZ_CHECK(close_enough(second->humidity, first->humidity, 0.05), "humidity drifted");
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Parse-throughput check for the data_filter JSON path.
+//
+// Builds a batch of simulator-format messages with MessageBuilder, then
+// parses it repeatedly. Every parse is compared against its source reading,
+// so a faster parser cannot pass by returning wrong values. Prints msgs/s
+// and fails if MIN_PARSE_RATE (msgs/s) is set and not met.
+
+#include "message_builder.h"
+#include "json_parser.h"
+#include "fuzz_check.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main() {
+    using iot_edge::JsonParser;
+    using iot_edge::fuzz::close_enough;
+
+    constexpr size_t kBatch = 10000;
+    constexpr int kRounds = 20;
+
+    std::vector<iot_edge::TemperatureSensor::Reading> readings;
+    std::vector<std::string> lines;
+    readings.reserve(kBatch);
+    lines.reserve(kBatch);
+
+    iot_edge::TemperatureSensor sensor("temp-sensor-001");
+    for (size_t i = 0; i < kBatch; ++i) {
+        readings.push_back(sensor.read());
+        lines.push_back(iot_edge::MessageBuilder::to_json(readings.back()));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        for (size_t i = 0; i < kBatch; ++i) {
+            auto msg = JsonParser::parse_sensor_message(lines[i]);
+            const auto& want = readings[i];
+            FUZZ_CHECK(msg.has_value(), "simulator message does not parse");
+            FUZZ_CHECK(msg->sequence_number == want.sequence_number, "sequenceNumber mismatch");
+            FUZZ_CHECK(msg->sensor_id == want.sensor_id, "sensorId mismatch");
+            FUZZ_CHECK(close_enough(msg->temperature, want.temperature_celsius, 0.005),
+                       "temperature mismatch");
+            FUZZ_CHECK(close_enough(msg->humidity, want.humidity_percent, 0.05),
+                       "humidity mismatch");
+            FUZZ_CHECK(msg->timestamp == want.timestamp, "timestamp mismatch");
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double rate = static_cast<double>(kBatch * kRounds) / elapsed.count();
+    std::cout << "[parse_throughput] " << kBatch * kRounds << " messages in "
+              << elapsed.count() << " s (" << static_cast<uint64_t>(rate) << " msgs/s)\n";
+
+    const char* min_rate = std::getenv("MIN_PARSE_RATE");
+    if (min_rate && rate < std::atof(min_rate)) {
+        std::cerr << "[parse_throughput] FAIL: below MIN_PARSE_RATE=" << min_rate << "\n";
+        return 1;
+    }
+    return 0;
+}
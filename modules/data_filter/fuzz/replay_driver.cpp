@@ -0,0 +1,59 @@
+// Replay driver for compilers without libFuzzer (e.g. GCC).
+//
+// Feeds each file (or every file under each directory) given on the command
+// line to LLVMFuzzerTestOneInput; with no arguments it reads one input from
+// stdin, which also makes the targets usable with AFL++'s stdin mode.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace fs = std::filesystem;
+
+static void run_one(const std::string& bytes) {
+    LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+}
+
+static bool run_file(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "[fuzz] ERROR: Could not read " << path << "\n";
+        return false;
+    }
+    run_one(std::string(std::istreambuf_iterator<char>(in), {}));
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        run_one(std::string(std::istreambuf_iterator<char>(std::cin), {}));
+        return 0;
+    }
+
+    size_t count = 0;
+    for (int i = 1; i < argc; ++i) {
+        fs::path arg(argv[i]);
+        std::vector<fs::path> files;
+        if (fs::is_directory(arg)) {
+            for (const auto& entry : fs::recursive_directory_iterator(arg)) {
+                if (entry.is_regular_file()) files.push_back(entry.path());
+            }
+        } else {
+            files.push_back(arg);
+        }
+        for (const auto& file : files) {
+            if (!run_file(file)) return 1;
+            count++;
+        }
+    }
+
+    std::cerr << "[fuzz] Replayed " << count << " inputs\n";
+    return 0;
+}
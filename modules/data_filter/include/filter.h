@@ -1,14 +1,28 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <deque>
 
 namespace iot_edge {
 
+/// Compact reason code for a rejected reading.
+enum class RejectReason : uint8_t {
+    None = 0,
+    OutOfRange,
+    SpikeDetected,
+    ParseError,
+};
+
+constexpr size_t kRejectReasonCount = 4;
+
+/// Stable wire name for a reason code, e.g. "out_of_range".
+const char* to_string(RejectReason reason);
+
 /// Filter result with reason for rejection.
 struct FilterResult {
     bool accepted;
-    std::string reason;  // empty if accepted
+    RejectReason reason;  // None if accepted
 };
 
 /// Validates and filters sensor data, rejecting out-of-range or noisy readings.
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace iot_edge {
+
+/// Multiplexes newline-framed input from several local sources with epoll.
+/// Every stream connection keeps its own line buffer, so partial lines from
+/// different producers never interleave. Used by standalone mode only.
+class InputMux {
+public:
+    using LineHandler = std::function<void(const std::string& line)>;
+
+    explicit InputMux(size_t max_line_bytes = 64 * 1024);
+    ~InputMux();
+
+    InputMux(const InputMux&) = delete;
+    InputMux& operator=(const InputMux&) = delete;
+
+    /// Read from standard input until EOF. A regular file or /dev/null on
+    /// stdin cannot be registered with epoll; it is read as always ready.
+    bool add_stdin();
+
+    /// Read from a named pipe. The pipe is held open for writing as well so
+    /// producers can restart without the filter seeing EOF.
+    bool add_fifo(const std::string& path);
+
+    /// Listen on a Unix domain stream socket; each client is framed separately.
+    bool add_unix_listener(const std::string& path);
+
+    /// Receive datagrams on a UDP port. Each datagram holds one or more lines.
+    bool add_udp(const std::string& host, uint16_t port);
+
+    /// Add sources from a comma-separated spec, e.g.
+    /// "stdin,fifo:/pipes/a,unix:/tmp/filter.sock,udp:5005,udp:0.0.0.0:5006".
+    /// Returns false and sets `error` on the first source that fails.
+    bool add_sources(const std::string& spec, std::string& error);
+
+    /// Wait up to `timeout_ms` for input and dispatch every complete line.
+    /// Returns false once no sources remain open.
+    bool poll(int timeout_ms, const LineHandler& handler);
+
+    size_t source_count() const { return sources_.size(); }
+
+private:
+    enum class Kind { Stream, Listener, Datagram };
+
+    struct Source {
+        int fd;
+        Kind kind;
+        bool owns_fd;
+        std::string pending;       // bytes after the last newline
+        bool discarding = false;   // current line exceeded max_line_bytes_
+        bool always_ready = false; // regular file: not in epoll, never blocks
+    };
+
+    int epoll_fd_;
+    size_t max_line_bytes_;
+    std::unordered_map<int, Source> sources_;
+    std::vector<char> read_buf_;
+    std::vector<int> fifo_write_fds_;
+    std::vector<std::string> socket_paths_;
+    std::vector<int> always_ready_fds_;
+    std::vector<int> paused_listeners_;        // out of fds; not in epoll
+    std::chrono::steady_clock::time_point resume_at_;
+
+    bool add_fd(int fd, Kind kind, bool owns_fd);
+    void close_source(int fd);
+
+    void drain_stream(Source& src, const LineHandler& handler);
+    void drain_datagrams(Source& src, const LineHandler& handler);
+    void accept_clients(Source& src);
+    void pause_listener(Source& src);
+    void resume_listeners();
+    void frame(Source& src, const char* data, size_t len, const LineHandler& handler);
+    void emit(std::string& line, const LineHandler& handler);
+};
+
+}  // namespace iot_edge
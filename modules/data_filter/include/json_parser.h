@@ -24,6 +24,10 @@ public:
     static std::string to_json(const SensorMessage& msg, bool filter_passed,
                                 const std::string& filter_reason = "");
 
+    /// Wrap a payload that could not be parsed, escaped as a JSON string.
+    static std::string to_rejected_json(const std::string& raw,
+                                         const std::string& filter_reason);
+
 private:
     static std::optional<std::string> extract_string(const std::string& json,
                                                       const std::string& key);
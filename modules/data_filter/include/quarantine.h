@@ -0,0 +1,61 @@
+#pragma once
+
+#include "filter.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace iot_edge {
+
+/// Accounts for rejected readings without a write per rejection.
+/// Counts are kept per reason code and reported as one summary line per
+/// interval. Standalone mode can also buffer the rejected records to an fd.
+class Quarantine {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Quarantine(std::chrono::seconds summary_interval = std::chrono::seconds(10));
+    ~Quarantine();
+
+    Quarantine(const Quarantine&) = delete;
+    Quarantine& operator=(const Quarantine&) = delete;
+
+    /// Append rejected records to `path`. Returns false with errno set.
+    bool open_path(const std::string& path);
+
+    /// Write rejected records to an already-open fd (not closed by us).
+    void set_fd(int fd);
+
+    bool has_output() const { return fd_ >= 0; }
+
+    /// Count a rejection and, if an output is configured, buffer `record`
+    /// as one line.
+    void reject(RejectReason reason, const std::string& record);
+
+    /// Flush buffered records and print a summary if the interval elapsed.
+    void tick(Clock::time_point now = Clock::now());
+
+    /// Flush buffered records and print the summary for any pending counts.
+    void flush();
+
+    uint64_t total(RejectReason reason) const {
+        return totals_[static_cast<size_t>(reason)];
+    }
+
+private:
+    std::chrono::seconds interval_;
+    Clock::time_point window_start_;
+    std::array<uint64_t, kRejectReasonCount> window_{};
+    std::array<uint64_t, kRejectReasonCount> totals_{};
+
+    int fd_ = -1;
+    bool owns_fd_ = false;
+    std::string buffer_;
+
+    void write_buffer();
+    void print_summary();
+};
+
+}  // namespace iot_edge
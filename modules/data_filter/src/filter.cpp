@@ -4,6 +4,16 @@
 
 namespace iot_edge {
 
+const char* to_string(RejectReason reason) {
+    switch (reason) {
+        case RejectReason::None:          return "";
+        case RejectReason::OutOfRange:    return "out_of_range";
+        case RejectReason::SpikeDetected: return "spike_detected";
+        case RejectReason::ParseError:    return "parse_error";
+    }
+    return "unknown";
+}
+
 DataFilter::DataFilter()
     : config_()
 {
@@ -20,7 +30,7 @@ FilterResult DataFilter::evaluate(double temperature) {
     // Check 1: Physical range validation
     if (!is_in_range(temperature)) {
         rejected_++;
-        return {false, "out_of_range"};
+        return {false, RejectReason::OutOfRange};
     }
 
     // Check 2: Spike detection (sudden jumps likely indicate sensor error)
@@ -31,7 +41,7 @@ FilterResult DataFilter::evaluate(double temperature) {
         if (recent_readings_.size() > config_.spike_window) {
             recent_readings_.pop_front();
         }
-        return {false, "spike_detected"};
+        return {false, RejectReason::SpikeDetected};
     }
 
     // Reading passed all checks
@@ -41,7 +51,7 @@ FilterResult DataFilter::evaluate(double temperature) {
     }
 
     accepted_++;
-    return {true, ""};
+    return {true, RejectReason::None};
 }
 
 bool DataFilter::is_in_range(double temp) const {
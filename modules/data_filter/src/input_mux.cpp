@@ -0,0 +1,348 @@
+#include "input_mux.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <algorithm>
+#include <unistd.h>
+#include <utility>
+
+namespace iot_edge {
+
+namespace {
+
+constexpr size_t kReadChunk = 64 * 1024;
+constexpr int kMaxEvents = 32;
+constexpr int kMaxDatagramsPerEvent = 16;
+constexpr auto kAcceptBackoff = std::chrono::milliseconds(100);
+
+}  // namespace
+
+InputMux::InputMux(size_t max_line_bytes)
+    : epoll_fd_(epoll_create1(EPOLL_CLOEXEC))
+    , max_line_bytes_(max_line_bytes)
+    , read_buf_(kReadChunk)
+{
+}
+
+InputMux::~InputMux() {
+    while (!sources_.empty()) {
+        close_source(sources_.begin()->first);
+    }
+    for (int fd : fifo_write_fds_) ::close(fd);
+    for (const auto& path : socket_paths_) ::unlink(path.c_str());
+    if (epoll_fd_ >= 0) ::close(epoll_fd_);
+}
+
+bool InputMux::add_stdin() {
+    return add_fd(STDIN_FILENO, Kind::Stream, false);
+}
+
+bool InputMux::add_fifo(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    // A FIFO reports EOF whenever its last writer exits. Holding our own
+    // write end keeps the reader attached across producer restarts.
+    int wfd = ::open(path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (wfd < 0 || !add_fd(fd, Kind::Stream, true)) {
+        int saved = errno;
+        if (wfd >= 0) ::close(wfd);
+        ::close(fd);
+        errno = saved;
+        return false;
+    }
+    fifo_write_fds_.push_back(wfd);
+    return true;
+}
+
+bool InputMux::add_unix_listener(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // Only a stale socket from a previous run may be replaced; never delete
+    // a FIFO or file that a mistyped spec happens to point at.
+    struct stat st{};
+    if (::lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            errno = EEXIST;
+            return false;
+        }
+        ::unlink(path.c_str());
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0 ||
+        !add_fd(fd, Kind::Listener, true)) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        return false;
+    }
+    socket_paths_.push_back(path);
+    return true;
+}
+
+bool InputMux::add_udp(const std::string& host, uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        errno = EINVAL;
+        return false;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        !add_fd(fd, Kind::Datagram, true)) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        return false;
+    }
+    return true;
+}
+
+bool InputMux::add_sources(const std::string& spec, std::string& error) {
+    size_t start = 0;
+    while (start <= spec.size()) {
+        size_t comma = spec.find(',', start);
+        if (comma == std::string::npos) comma = spec.size();
+        std::string item = spec.substr(start, comma - start);
+        start = comma + 1;
+        if (item.empty()) continue;
+
+        auto colon = item.find(':');
+        std::string kind = item.substr(0, colon);
+        std::string arg = colon == std::string::npos ? "" : item.substr(colon + 1);
+
+        bool ok = false;
+        if (kind == "stdin" && arg.empty()) {
+            ok = add_stdin();
+        } else if (kind == "fifo" && !arg.empty()) {
+            ok = add_fifo(arg);
+        } else if (kind == "unix" && !arg.empty()) {
+            ok = add_unix_listener(arg);
+        } else if (kind == "udp" && !arg.empty()) {
+            std::string host = "127.0.0.1";
+            auto sep = arg.rfind(':');
+            if (sep != std::string::npos) {
+                host = arg.substr(0, sep);
+                arg = arg.substr(sep + 1);
+            }
+            try {
+                size_t processed = 0;
+                unsigned long port = std::stoul(arg, &processed);
+                if (processed == arg.size() && port <= 65535) {
+                    ok = add_udp(host, static_cast<uint16_t>(port));
+                } else {
+                    errno = EINVAL;
+                }
+            } catch (...) {
+                errno = EINVAL;
+            }
+        } else {
+            errno = EINVAL;
+        }
+
+        if (!ok) {
+            error = item + ": " + std::strerror(errno);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool InputMux::poll(int timeout_ms, const LineHandler& handler) {
+    if (sources_.empty()) return false;
+
+    auto now = std::chrono::steady_clock::now();
+    if (!paused_listeners_.empty()) {
+        if (now >= resume_at_) {
+            resume_listeners();
+        } else {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                resume_at_ - now).count() + 1;
+            if (timeout_ms < 0 || left < timeout_ms) timeout_ms = static_cast<int>(left);
+        }
+    }
+    // Regular files always have data (or EOF) ready, so never sleep on them.
+    if (!always_ready_fds_.empty()) timeout_ms = 0;
+
+    epoll_event events[kMaxEvents];
+    int n = ::epoll_wait(epoll_fd_, events, kMaxEvents, timeout_ms);
+    if (n < 0) {
+        // EINTR is the normal path for SIGINT/SIGTERM; let the caller re-check.
+        return errno == EINTR;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        auto it = sources_.find(events[i].data.fd);
+        if (it == sources_.end()) continue;
+
+        Source& src = it->second;
+        switch (src.kind) {
+            case Kind::Stream:   drain_stream(src, handler); break;
+            case Kind::Listener: accept_clients(src); break;
+            case Kind::Datagram: drain_datagrams(src, handler); break;
+        }
+    }
+
+    // Copy: drain_stream removes the fd from the list on EOF.
+    std::vector<int> ready = always_ready_fds_;
+    for (int fd : ready) {
+        auto it = sources_.find(fd);
+        if (it != sources_.end()) drain_stream(it->second, handler);
+    }
+
+    return !sources_.empty();
+}
+
+bool InputMux::add_fd(int fd, Kind kind, bool owns_fd) {
+    if (epoll_fd_ < 0) return false;
+
+    Source src;
+    src.fd = fd;
+    src.kind = kind;
+    src.owns_fd = owns_fd;
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        // epoll rejects regular files with EPERM; reads on them never block.
+        if (errno != EPERM || kind != Kind::Stream) return false;
+        src.always_ready = true;
+        always_ready_fds_.push_back(fd);
+    }
+
+    sources_.emplace(fd, std::move(src));
+    return true;
+}
+
+void InputMux::close_source(int fd) {
+    auto it = sources_.find(fd);
+    if (it == sources_.end()) return;
+
+    if (it->second.always_ready) {
+        always_ready_fds_.erase(
+            std::remove(always_ready_fds_.begin(), always_ready_fds_.end(), fd),
+            always_ready_fds_.end());
+    } else {
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+    paused_listeners_.erase(
+        std::remove(paused_listeners_.begin(), paused_listeners_.end(), fd),
+        paused_listeners_.end());
+    if (it->second.owns_fd) ::close(fd);
+    sources_.erase(it);
+}
+
+void InputMux::drain_stream(Source& src, const LineHandler& handler) {
+    // One read per readiness event: epoll is level-triggered, so a busy
+    // producer cannot starve the others.
+    ssize_t got = ::read(src.fd, read_buf_.data(), read_buf_.size());
+    if (got > 0) {
+        frame(src, read_buf_.data(), static_cast<size_t>(got), handler);
+        return;
+    }
+    if (got < 0 && (errno == EAGAIN || errno == EINTR)) return;
+
+    // EOF or hard error: deliver a trailing unterminated line, then drop.
+    if (!src.pending.empty() && !src.discarding) emit(src.pending, handler);
+    close_source(src.fd);
+}
+
+void InputMux::drain_datagrams(Source& src, const LineHandler& handler) {
+    // Bounded like drain_stream: the rest stays queued for the next event.
+    for (int i = 0; i < kMaxDatagramsPerEvent; ++i) {
+        ssize_t got = ::recv(src.fd, read_buf_.data(), read_buf_.size(), MSG_DONTWAIT);
+        if (got < 0) return;
+
+        // Datagrams are self-contained: a trailing line needs no newline.
+        frame(src, read_buf_.data(), static_cast<size_t>(got), handler);
+        if (!src.pending.empty() && !src.discarding) emit(src.pending, handler);
+        src.pending.clear();
+        src.discarding = false;
+    }
+}
+
+void InputMux::accept_clients(Source& src) {
+    for (;;) {
+        int client = ::accept4(src.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client < 0) {
+            // The pending connection stays queued and the listener stays
+            // readable, so a level-triggered epoll would spin until an fd
+            // frees up. Stop watching it for a while instead.
+            if (errno == EMFILE || errno == ENFILE) pause_listener(src);
+            return;
+        }
+        if (!add_fd(client, Kind::Stream, true)) ::close(client);
+    }
+}
+
+void InputMux::pause_listener(Source& src) {
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, src.fd, nullptr);
+    paused_listeners_.push_back(src.fd);
+    resume_at_ = std::chrono::steady_clock::now() + kAcceptBackoff;
+}
+
+void InputMux::resume_listeners() {
+    for (int fd : paused_listeners_) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+    paused_listeners_.clear();
+}
+
+void InputMux::frame(Source& src, const char* data, size_t len,
+                     const LineHandler& handler) {
+    while (len > 0) {
+        const char* nl = static_cast<const char*>(std::memchr(data, '\n', len));
+        size_t take = nl ? static_cast<size_t>(nl - data) : len;
+
+        if (!src.discarding) {
+            if (src.pending.size() + take > max_line_bytes_) {
+                // Oversized line: drop it rather than buffer without bound.
+                src.pending.clear();
+                src.discarding = true;
+            } else {
+                src.pending.append(data, take);
+            }
+        }
+
+        if (!nl) return;
+
+        if (!src.discarding) emit(src.pending, handler);
+        src.pending.clear();
+        src.discarding = false;
+
+        data = nl + 1;
+        len -= take + 1;
+    }
+}
+
+void InputMux::emit(std::string& line, const LineHandler& handler) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    handler(line);
+}
+
+}  // namespace iot_edge
@@ -45,6 +45,25 @@ std::string JsonParser::to_json(const SensorMessage& msg, bool filter_passed,
     return oss.str();
 }
 
+std::string JsonParser::to_rejected_json(const std::string& raw,
+                                          const std::string& filter_reason) {
+    std::ostringstream oss;
+    oss << "{\"filterPassed\":false,\"filterReason\":\"" << filter_reason
+        << "\",\"raw\":\"";
+    for (unsigned char c : raw) {
+        if (c == '"' || c == '\\') {
+            oss << '\\' << c;
+        } else if (c < 0x20) {
+            oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                << static_cast<int>(c) << std::dec;
+        } else {
+            oss << c;
+        }
+    }
+    oss << "\"}";
+    return oss.str();
+}
+
 std::optional<std::string> JsonParser::extract_string(const std::string& json,
                                                        const std::string& key) {
     std::string search = "\"" + key + "\":\"";
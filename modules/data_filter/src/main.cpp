@@ -1,11 +1,17 @@
 #include "filter.h"
 #include "json_parser.h"
+#include "quarantine.h"
+#include "input_mux.h"
+#include "shm_ring.h"
 
 #include <iostream>
 #include <string>
 #include <csignal>
 #include <cstdlib>
 #include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <chrono>
 
 #ifndef STANDALONE_MODE
 #include "iothub_module_client_ll.h"
@@ -23,6 +29,15 @@ static void signal_handler(int sig) {
     g_running = false;
 }
 
+static int get_env_int(const char* name, int default_val) {
+    const char* val = std::getenv(name);
+    if (val) {
+        try { return std::stoi(val); }
+        catch (...) {}
+    }
+    return default_val;
+}
+
 static double get_env_double(const char* name, double default_val) {
     const char* val = std::getenv(name);
     if (val) {
@@ -46,19 +61,40 @@ int main() {
 
     iot_edge::DataFilter filter(config);
 
+    // Rejections are summarized per reason on stderr; the records themselves
+    // go to QUARANTINE_PATH (appended) or an inherited QUARANTINE_FD if set.
+    int summary_sec = get_env_int("QUARANTINE_SUMMARY_SEC", 10);
+    if (summary_sec <= 0) {
+        std::cerr << "[data_filter] ERROR: QUARANTINE_SUMMARY_SEC must be at least 1\n";
+        return 1;
+    }
+    iot_edge::Quarantine quarantine{std::chrono::seconds(summary_sec)};
+    const char* quarantine_path = std::getenv("QUARANTINE_PATH");
+    if (quarantine_path && *quarantine_path) {
+        if (!quarantine.open_path(quarantine_path)) {
+            std::cerr << "[data_filter] ERROR: Could not open quarantine file "
+                      << quarantine_path << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+    } else if (int fd = get_env_int("QUARANTINE_FD", -1); fd >= 0) {
+        quarantine.set_fd(fd);
+    }
+
     std::cerr << "[data_filter] Starting in STANDALONE mode\n";
     std::cerr << "[data_filter] Valid range: [" << config.temp_min_valid
               << ", " << config.temp_max_valid << "] C\n";
     std::cerr << "---\n";
 
-    std::string line;
-    while (g_running && std::getline(std::cin, line)) {
-        if (line.empty()) continue;
+    auto process_line = [&filter, &quarantine](const std::string& line) {
+        if (line.empty()) return;
 
         auto msg = iot_edge::JsonParser::parse_sensor_message(line);
         if (!msg) {
-            std::cerr << "[data_filter] WARNING: Failed to parse message\n";
-            continue;
+            auto reason = iot_edge::RejectReason::ParseError;
+            quarantine.reject(reason, quarantine.has_output()
+                ? iot_edge::JsonParser::to_rejected_json(line, iot_edge::to_string(reason))
+                : std::string());
+            return;
         }
 
         auto result = filter.evaluate(msg->temperature);
@@ -67,15 +103,73 @@ int main() {
             // Forward clean data to stdout
             std::cout << iot_edge::JsonParser::to_json(*msg, true) << std::endl;
         } else {
-            std::cerr << "[data_filter] Rejected seq=" << msg->sequence_number
-                      << " temp=" << msg->temperature
-                      << " reason=" << result.reason << "\n";
+            quarantine.reject(result.reason, quarantine.has_output()
+                ? iot_edge::JsonParser::to_json(*msg, false, iot_edge::to_string(result.reason))
+                : std::string());
+        }
+    };
+
+    // SHM_RING_NAME reads from sensor_simulator's shared-memory ring.
+    // FILTER_INPUTS multiplexes several producers (FIFOs, Unix socket, UDP)
+    // into this one filter. Without either we read stdin exactly as before.
+    const char* ring_name = std::getenv("SHM_RING_NAME");
+    const char* inputs = std::getenv("FILTER_INPUTS");
+    if (ring_name && *ring_name) {
+        int ring_bytes = get_env_int("SHM_RING_BYTES", 1 << 20);
+        if (ring_bytes <= 0 || static_cast<size_t>(ring_bytes) > iot_edge::ShmRing::kMaxCapacity) {
+            std::cerr << "[data_filter] ERROR: SHM_RING_BYTES must be in [1, "
+                      << iot_edge::ShmRing::kMaxCapacity << "]\n";
+            return 1;
+        }
+
+        iot_edge::ShmRing ring;
+        if (!ring.open(ring_name, static_cast<size_t>(ring_bytes),
+                       iot_edge::ShmRing::Role::Consumer)) {
+            std::cerr << "[data_filter] ERROR: Could not open shared-memory ring "
+                      << ring_name << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        std::cerr << "[data_filter] Input: shm " << ring_name
+                  << " (" << ring.capacity() << " bytes)\n";
+
+        std::string line;
+        while (g_running) {
+            auto status = ring.read(line, 500);
+            if (status == iot_edge::ShmRing::Status::Corrupt) {
+                // glibc maps "/name" and "name" alike to /dev/shm/name
+                const char* file = ring_name + (ring_name[0] == '/' ? 1 : 0);
+                std::cerr << "[data_filter] ERROR: Shared-memory ring " << ring_name
+                          << " is corrupt; remove /dev/shm/" << file << " and restart\n";
+                return 1;
+            }
+            if (status == iot_edge::ShmRing::Status::Ok) process_line(line);
+            quarantine.tick();
+        }
+    } else if (inputs && *inputs) {
+        iot_edge::InputMux mux;
+        std::string error;
+        if (!mux.add_sources(inputs, error)) {
+            std::cerr << "[data_filter] ERROR: Invalid input " << error << "\n";
+            return 1;
+        }
+        std::cerr << "[data_filter] Inputs: " << inputs << "\n";
+
+        while (g_running && mux.poll(500, process_line)) {
+            quarantine.tick();
+        }
+    } else {
+        std::string line;
+        while (g_running && std::getline(std::cin, line)) {
+            process_line(line);
+            quarantine.tick();
         }
     }
 
+    quarantine.flush();
     std::cerr << "[data_filter] Stats: total=" << filter.total_count()
               << " accepted=" << filter.accepted_count()
-              << " rejected=" << filter.rejected_count() << "\n";
+              << " rejected=" << filter.rejected_count()
+              << " parse_errors=" << quarantine.total(iot_edge::RejectReason::ParseError) << "\n";
     std::cerr << "[data_filter] Stopped.\n";
     return 0;
 }
@@ -85,8 +179,30 @@ int main() {
 // ─── IoT Edge mode: receives from Edge Hub input, sends to output ───
 
 static iot_edge::DataFilter* g_filter = nullptr;
+static iot_edge::Quarantine* g_quarantine = nullptr;
 static IOTHUB_MODULE_CLIENT_LL_HANDLE g_client = nullptr;
 
+static void send_to_output(const std::string& json, const char* output_name,
+                           iot_edge::RejectReason reason)
+{
+    IOTHUB_MESSAGE_HANDLE output_msg = IoTHubMessage_CreateFromString(json.c_str());
+    if (!output_msg) return;
+
+    bool passed = reason == iot_edge::RejectReason::None;
+    IoTHubMessage_SetContentTypeSystemProperty(output_msg, "application/json");
+    IoTHubMessage_SetContentEncodingSystemProperty(output_msg, "utf-8");
+    IoTHubMessage_SetProperty(output_msg, "source", "dataFilter");
+    IoTHubMessage_SetProperty(output_msg, "filterPassed", passed ? "true" : "false");
+    if (!passed) {
+        IoTHubMessage_SetProperty(output_msg, "filterReason", iot_edge::to_string(reason));
+    }
+
+    IoTHubModuleClient_LL_SendEventToOutputAsync(
+        g_client, output_msg, output_name, nullptr, nullptr);
+
+    IoTHubMessage_Destroy(output_msg);
+}
+
 static IOTHUBMESSAGE_DISPOSITION_RESULT input_message_callback(
     IOTHUB_MESSAGE_HANDLE message, void* /*userContext*/)
 {
@@ -102,28 +218,24 @@ static IOTHUBMESSAGE_DISPOSITION_RESULT input_message_callback(
     auto msg = iot_edge::JsonParser::parse_sensor_message(json);
 
     if (!msg) {
-        std::cerr << "[data_filter] WARNING: Failed to parse message\n";
+        auto reason = iot_edge::RejectReason::ParseError;
+        g_quarantine->reject(reason, "");
+        send_to_output(iot_edge::JsonParser::to_rejected_json(json, iot_edge::to_string(reason)),
+                       "filterRejected", reason);
         return IOTHUBMESSAGE_REJECTED;
     }
 
     auto result = g_filter->evaluate(msg->temperature);
 
     if (result.accepted) {
-        std::string output_json = iot_edge::JsonParser::to_json(*msg, true);
-        IOTHUB_MESSAGE_HANDLE output_msg =
-            IoTHubMessage_CreateFromString(output_json.c_str());
-
-        if (output_msg) {
-            IoTHubMessage_SetContentTypeSystemProperty(output_msg, "application/json");
-            IoTHubMessage_SetContentEncodingSystemProperty(output_msg, "utf-8");
-            IoTHubMessage_SetProperty(output_msg, "source", "dataFilter");
-            IoTHubMessage_SetProperty(output_msg, "filterPassed", "true");
-
-            IoTHubModuleClient_LL_SendEventToOutputAsync(
-                g_client, output_msg, "filterOutput", nullptr, nullptr);
-
-            IoTHubMessage_Destroy(output_msg);
-        }
+        send_to_output(iot_edge::JsonParser::to_json(*msg, true),
+                       "filterOutput", result.reason);
+    } else {
+        // Rejected readings go to their own output for root-cause analysis;
+        // counts are summarized on stderr instead of logged one by one.
+        g_quarantine->reject(result.reason, "");
+        send_to_output(iot_edge::JsonParser::to_json(*msg, false, iot_edge::to_string(result.reason)),
+                       "filterRejected", result.reason);
     }
 
     return IOTHUBMESSAGE_ACCEPTED;
@@ -135,6 +247,12 @@ int main() {
 
     std::cerr << "[data_filter] Starting in IoT Edge mode\n";
 
+    int summary_sec = get_env_int("QUARANTINE_SUMMARY_SEC", 10);
+    if (summary_sec <= 0) {
+        std::cerr << "[data_filter] ERROR: QUARANTINE_SUMMARY_SEC must be at least 1\n";
+        return 1;
+    }
+
     if (platform_init() != 0) {
         std::cerr << "[data_filter] ERROR: platform_init failed\n";
         return 1;
@@ -155,20 +273,26 @@ int main() {
     iot_edge::DataFilter filter(config);
     g_filter = &filter;
 
+    iot_edge::Quarantine quarantine{std::chrono::seconds(summary_sec)};
+    g_quarantine = &quarantine;
+
     IoTHubModuleClient_LL_SetInputMessageCallback(
         g_client, "filterInput", input_message_callback, nullptr);
 
     while (g_running) {
         IoTHubModuleClient_LL_DoWork(g_client);
+        quarantine.tick();
         ThreadAPI_Sleep(100);
     }
 
     IoTHubModuleClient_LL_Destroy(g_client);
     platform_deinit();
 
+    quarantine.flush();
     std::cerr << "[data_filter] Stats: total=" << filter.total_count()
               << " accepted=" << filter.accepted_count()
-              << " rejected=" << filter.rejected_count() << "\n";
+              << " rejected=" << filter.rejected_count()
+              << " parse_errors=" << quarantine.total(iot_edge::RejectReason::ParseError) << "\n";
     std::cerr << "[data_filter] Stopped.\n";
     return 0;
 }
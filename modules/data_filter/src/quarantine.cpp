@@ -0,0 +1,144 @@
+#include "quarantine.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+namespace iot_edge {
+
+namespace {
+
+constexpr size_t kFlushThreshold = 64 * 1024;
+
+}  // namespace
+
+Quarantine::Quarantine(std::chrono::seconds summary_interval)
+    : interval_(summary_interval)
+    , window_start_(Clock::now())
+{
+}
+
+Quarantine::~Quarantine() {
+    flush();
+    if (owns_fd_) ::close(fd_);
+}
+
+bool Quarantine::open_path(const std::string& path) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    if (owns_fd_) ::close(fd_);
+    fd_ = fd;
+    owns_fd_ = true;
+    return true;
+}
+
+void Quarantine::set_fd(int fd) {
+    if (owns_fd_) ::close(fd_);
+    fd_ = fd;
+    owns_fd_ = false;
+}
+
+void Quarantine::reject(RejectReason reason, const std::string& record) {
+    auto idx = static_cast<size_t>(reason);
+    window_[idx]++;
+    totals_[idx]++;
+
+    if (fd_ < 0) return;
+    buffer_ += record;
+    buffer_ += '\n';
+    if (buffer_.size() >= kFlushThreshold) write_buffer();
+}
+
+void Quarantine::tick(Clock::time_point now) {
+    // Records are only written here once per interval (or by reject() at
+    // kFlushThreshold), never once per rejection.
+    if (now - window_start_ < interval_) return;
+
+    write_buffer();
+    print_summary();
+    window_start_ = now;
+}
+
+void Quarantine::flush() {
+    write_buffer();
+    print_summary();
+}
+
+void Quarantine::write_buffer() {
+    if (fd_ < 0 || buffer_.empty()) {
+        buffer_.clear();
+        return;
+    }
+
+    // The quarantine fd may be a pipe or FIFO. Keep SIGPIPE blocked while
+    // writing so a departed reader surfaces as EPIPE instead of killing us.
+    sigset_t pipe_set, old_set;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+    size_t off = 0;
+    int err = 0;
+    while (off < buffer_.size()) {
+        ssize_t n = ::write(fd_, buffer_.data() + off, buffer_.size() - off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            err = errno;
+            break;
+        }
+        off += static_cast<size_t>(n);
+    }
+
+    if (err == EPIPE) {
+        timespec zero{0, 0};
+        sigtimedwait(&pipe_set, nullptr, &zero);  // discard the pending SIGPIPE
+    }
+    pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+
+    if (err == EPIPE) {
+        // Reader went away: stop writing records; counts still reach the summary.
+        std::cerr << "[data_filter] WARNING: Quarantine reader closed, records disabled\n";
+        if (owns_fd_) ::close(fd_);
+        fd_ = -1;
+        owns_fd_ = false;
+    } else if (err == EAGAIN) {
+        // Reader is behind. Drop whole records rather than buffer without
+        // bound, but finish a record cut mid-line so the output stays JSONL.
+        size_t keep = off;
+        if (off > 0 && buffer_[off - 1] != '\n') keep = buffer_.find('\n', off) + 1;
+        size_t dropped = 0;
+        for (size_t i = keep; i < buffer_.size(); ++i) dropped += buffer_[i] == '\n';
+        buffer_.erase(keep);
+        buffer_.erase(0, off);
+        if (dropped > 0) {
+            std::cerr << "[data_filter] WARNING: Quarantine reader is behind, dropped "
+                      << dropped << " records\n";
+        }
+        return;
+    } else if (err != 0) {
+        std::cerr << "[data_filter] WARNING: Quarantine write failed: "
+                  << std::strerror(err) << "\n";
+    }
+    buffer_.clear();
+}
+
+void Quarantine::print_summary() {
+    uint64_t sum = 0;
+    for (uint64_t c : window_) sum += c;
+    if (sum == 0) return;
+
+    std::cerr << "[data_filter] Rejected " << sum << " since last summary:";
+    for (size_t i = 1; i < kRejectReasonCount; ++i) {
+        if (window_[i] == 0) continue;
+        std::cerr << ' ' << to_string(static_cast<RejectReason>(i)) << '=' << window_[i];
+    }
+    std::cerr << "\n";
+    window_.fill(0);
+}
+
+}  // namespace iot_edge
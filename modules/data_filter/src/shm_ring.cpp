@@ -0,0 +1,281 @@
+#include "shm_ring.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+
+namespace iot_edge {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x52474E49;    // "INGR"
+constexpr uint32_t kVersion = 3;
+constexpr uint32_t kWrapMarker = 0xFFFFFFFF;
+constexpr size_t kRecordAlign = 8;
+constexpr size_t kHeaderBytes = 4096;      // keeps the data area page aligned
+constexpr int kAttachTimeoutMs = 5000;
+
+size_t record_bytes(size_t payload) {
+    return (sizeof(uint32_t) + payload + kRecordAlign - 1) & ~(kRecordAlign - 1);
+}
+
+size_t round_up_pow2(size_t v) {
+    size_t p = 4096;
+    while (p < v && p < ShmRing::kMaxCapacity) p <<= 1;
+    return p;
+}
+
+// Shared (not FUTEX_PRIVATE) operations: the waiter and waker are different processes.
+void futex_wait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    timespec ts{timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT,
+            expected, &ts, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1,
+            nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+// Producer and consumer indices live on separate cache lines so the two
+// processes do not false-share. Offsets are monotonic byte counts.
+struct ShmRing::Header {
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint64_t capacity;
+    // One flag per Role rather than a count: a side restarting after a crash
+    // sets its flag again instead of adding to a count nobody decrements.
+    std::atomic<uint32_t> attached[2];
+
+    alignas(64) std::atomic<uint64_t> head;            // written by producer
+    alignas(64) std::atomic<uint64_t> tail;            // written by consumer
+
+    alignas(64) std::atomic<uint32_t> data_seq;        // futex: bumped per publish
+    std::atomic<uint32_t> consumer_waiting;
+    alignas(64) std::atomic<uint32_t> space_seq;       // futex: bumped per consume
+    std::atomic<uint32_t> producer_waiting;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring needs lock-free 64-bit atomics");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+
+ShmRing::~ShmRing() {
+    if (!header_) return;
+
+    // Last one out removes the name. A side that crashed stays flagged until
+    // it restarts, so its peer leaves the segment for the restart to reuse.
+    auto self = static_cast<size_t>(role_);
+    header_->attached[self].store(0);
+    if (header_->attached[1 - self].load() == 0) shm_unlink(name_.c_str());
+    munmap(header_, mapped_bytes_);
+}
+
+bool ShmRing::open(const std::string& name, size_t capacity, Role role) {
+    if (header_ || capacity == 0 || capacity > kMaxCapacity) {
+        errno = EINVAL;
+        return false;
+    }
+    name_ = name;
+    role_ = role;
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        switch (try_open(round_up_pow2(capacity))) {
+            case Attach::Ok:     return true;
+            case Attach::Failed: return false;
+            case Attach::Stale:
+                // The creator died before sizing or initializing the segment.
+                shm_unlink(name_.c_str());
+                break;
+        }
+    }
+    errno = ETIMEDOUT;
+    return false;
+}
+
+ShmRing::Attach ShmRing::try_open(size_t cap) {
+    static_assert(sizeof(Header) <= kHeaderBytes, "header exceeds reserved page");
+
+    bool created = true;
+    int fd = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (fd < 0 && errno == EEXIST) {
+        created = false;
+        fd = shm_open(name_.c_str(), O_RDWR, 0);
+    }
+    if (fd < 0) return Attach::Failed;
+
+    struct stat st{};
+    if (created) {
+        // ftruncate alone leaves tmpfs sparse: a ring bigger than /dev/shm
+        // would map fine and then SIGBUS once writes reach the missing pages.
+        int err = posix_fallocate(fd, 0, static_cast<off_t>(kHeaderBytes + cap));
+        if (err != 0) {
+            close(fd);
+            shm_unlink(name_.c_str());
+            errno = err;
+            return Attach::Failed;
+        }
+        st.st_size = static_cast<off_t>(kHeaderBytes + cap);
+    } else {
+        // The creator may still be sizing the segment.
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(kAttachTimeoutMs);
+        while (fstat(fd, &st) == 0 && st.st_size <= static_cast<off_t>(kHeaderBytes)) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                close(fd);
+                return Attach::Stale;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    size_t bytes = static_cast<size_t>(st.st_size);
+    void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (mem == MAP_FAILED) {
+        errno = saved;
+        return Attach::Failed;
+    }
+
+    auto* hdr = static_cast<Header*>(mem);
+    if (created) {
+        hdr->version = kVersion;
+        hdr->capacity = cap;
+        hdr->attached[0].store(0, std::memory_order_relaxed);
+        hdr->attached[1].store(0, std::memory_order_relaxed);
+        hdr->head.store(0, std::memory_order_relaxed);
+        hdr->tail.store(0, std::memory_order_relaxed);
+        hdr->data_seq.store(0, std::memory_order_relaxed);
+        hdr->consumer_waiting.store(0, std::memory_order_relaxed);
+        hdr->space_seq.store(0, std::memory_order_relaxed);
+        hdr->producer_waiting.store(0, std::memory_order_relaxed);
+        hdr->magic.store(kMagic, std::memory_order_release);
+    } else {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(kAttachTimeoutMs);
+        while (hdr->magic.load(std::memory_order_acquire) != kMagic) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                munmap(mem, bytes);
+                return Attach::Stale;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        uint64_t seg_cap = hdr->capacity;
+        if (hdr->version != kVersion || seg_cap < 4096 || seg_cap > kMaxCapacity ||
+            (seg_cap & (seg_cap - 1)) != 0 || seg_cap + kHeaderBytes > bytes) {
+            munmap(mem, bytes);
+            errno = EPROTO;
+            return Attach::Failed;
+        }
+    }
+
+    hdr->attached[static_cast<size_t>(role_)].store(1);
+    header_ = hdr;
+    data_ = static_cast<unsigned char*>(mem) + kHeaderBytes;
+    capacity_ = static_cast<size_t>(hdr->capacity);
+    mapped_bytes_ = bytes;
+    return Attach::Ok;
+}
+
+size_t ShmRing::max_message_bytes() const {
+    return capacity_ / 2 - sizeof(uint32_t);
+}
+
+ShmRing::Status ShmRing::write(const std::string& msg, int timeout_ms) {
+    if (!header_) return Status::Corrupt;
+    if (msg.size() > max_message_bytes()) return Status::TooLarge;
+
+    size_t need = record_bytes(msg.size());
+    const uint64_t mask = capacity_ - 1;
+    uint64_t head = header_->head.load(std::memory_order_relaxed);
+    size_t offset = static_cast<size_t>(head & mask);
+    size_t to_end = capacity_ - offset;
+    size_t total = to_end >= need ? need : to_end + need;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (capacity_ - (head - header_->tail.load(std::memory_order_acquire)) < total) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0) return Status::Timeout;
+
+        header_->producer_waiting.store(1);
+        uint32_t seq = header_->space_seq.load();
+        if (capacity_ - (head - header_->tail.load()) < total) {
+            futex_wait(&header_->space_seq, seq, static_cast<int>(left));
+        }
+        header_->producer_waiting.store(0);
+    }
+
+    if (to_end < need) {
+        // Not enough contiguous room: mark the tail end as skipped and wrap.
+        uint32_t marker = kWrapMarker;
+        std::memcpy(data_ + offset, &marker, sizeof(marker));
+        head += to_end;
+        offset = 0;
+    }
+
+    uint32_t len = static_cast<uint32_t>(msg.size());
+    std::memcpy(data_ + offset, &len, sizeof(len));
+    std::memcpy(data_ + offset + sizeof(len), msg.data(), msg.size());
+
+    header_->head.store(head + need);
+    header_->data_seq.fetch_add(1);
+    if (header_->consumer_waiting.load()) futex_wake(&header_->data_seq);
+    return Status::Ok;
+}
+
+ShmRing::Status ShmRing::read(std::string& out, int timeout_ms) {
+    if (!header_) return Status::Corrupt;
+
+    const uint64_t mask = capacity_ - 1;
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (head == tail) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0) return Status::Timeout;
+
+        header_->consumer_waiting.store(1);
+        uint32_t seq = header_->data_seq.load();
+        if (header_->head.load() == tail) {
+            futex_wait(&header_->data_seq, seq, static_cast<int>(left));
+        }
+        header_->consumer_waiting.store(0);
+        head = header_->head.load(std::memory_order_acquire);
+    }
+
+    // Everything below comes from shared memory: validate before trusting it.
+    size_t offset = static_cast<size_t>(tail & mask);
+    uint32_t len;
+    std::memcpy(&len, data_ + offset, sizeof(len));
+    if (len == kWrapMarker) {
+        tail += capacity_ - offset;
+        offset = 0;
+        if (tail >= head) return Status::Corrupt;
+        std::memcpy(&len, data_ + offset, sizeof(len));
+    }
+    if (len > capacity_ - offset - sizeof(len) || record_bytes(len) > head - tail) {
+        return Status::Corrupt;
+    }
+
+    out.assign(reinterpret_cast<const char*>(data_ + offset + sizeof(len)), len);
+
+    header_->tail.store(tail + record_bytes(len));
+    header_->space_seq.fetch_add(1);
+    if (header_->producer_waiting.load()) futex_wake(&header_->space_seq);
+    return Status::Ok;
+}
+
+}  // namespace iot_edge
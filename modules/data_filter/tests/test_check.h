@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// Unlike assert(), stays active in Release builds.
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "CHECK failed: %s (%s:%d)\n", #cond,       \
+                         __FILE__, __LINE__);                               \
+            std::exit(1);                                                   \
+        }                                                                   \
+    } while (0)
@@ -0,0 +1,295 @@
+// Tests for InputMux using local sockets, FIFOs and files only.
+
+#include "input_mux.h"
+#include "test_check.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+std::string temp_path(const char* name) {
+    return "/tmp/test_input_mux_" + std::to_string(getpid()) + "_" + name;
+}
+
+int connect_unix(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    CHECK(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+void send_all(int fd, const std::string& data) {
+    CHECK(write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size()));
+}
+
+/// Poll until `lines` holds `want` entries or a second passed. With
+/// want == 0 this just gives pending accepts and reads 100 ms to settle.
+void pump(iot_edge::InputMux& mux, std::vector<std::string>& lines, size_t want = 0) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    (want ? std::chrono::milliseconds(1000) : std::chrono::milliseconds(100));
+    while ((want == 0 || lines.size() < want) && std::chrono::steady_clock::now() < deadline) {
+        mux.poll(10, [&lines](const std::string& line) { lines.push_back(line); });
+    }
+}
+
+void test_unix_connections_are_framed_separately() {
+    std::string path = temp_path("framing.sock");
+    iot_edge::InputMux mux;
+    CHECK(mux.add_unix_listener(path));
+
+    std::vector<std::string> lines;
+    int a = connect_unix(path);
+    int b = connect_unix(path);
+    pump(mux, lines);  // accept both clients
+
+    // Interleave partial lines; each connection must keep its own buffer.
+    send_all(a, "{\"from\":\"a\",");
+    pump(mux, lines);
+    send_all(b, "{\"from\":\"b\"}\n");
+    pump(mux, lines, 1);
+    send_all(a, "\"seq\":1}\r\n");
+
+    pump(mux, lines, 2);
+    CHECK(lines.size() == 2);
+    CHECK(lines[0] == "{\"from\":\"b\"}");
+    CHECK(lines[1] == "{\"from\":\"a\",\"seq\":1}");
+
+    close(a);
+    close(b);
+}
+
+void test_oversized_line_is_dropped() {
+    std::string path = temp_path("oversized.sock");
+    iot_edge::InputMux mux(32);
+    CHECK(mux.add_unix_listener(path));
+
+    std::vector<std::string> lines;
+    int fd = connect_unix(path);
+    pump(mux, lines);
+    send_all(fd, std::string(20, 'x'));
+    pump(mux, lines);
+    send_all(fd, std::string(20, 'y') + "\nshort\n");
+
+    pump(mux, lines, 1);
+    CHECK(lines.size() == 1);
+    CHECK(lines[0] == "short");
+    close(fd);
+}
+
+void test_trailing_line_delivered_on_disconnect() {
+    std::string path = temp_path("eof.sock");
+    iot_edge::InputMux mux;
+    CHECK(mux.add_unix_listener(path));
+
+    std::vector<std::string> lines;
+    int fd = connect_unix(path);
+    pump(mux, lines);
+    send_all(fd, "no-newline");
+    close(fd);
+
+    pump(mux, lines, 1);
+    CHECK(lines.size() == 1);
+    CHECK(lines[0] == "no-newline");
+}
+
+void test_udp_datagram_lines() {
+    iot_edge::InputMux mux;
+    std::string error;
+    // Borrow a free loopback port from the kernel, then hand it to the mux.
+    int probe = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    CHECK(bind(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    CHECK(getsockname(probe, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+    close(probe);
+
+    CHECK(mux.add_sources("udp:" + std::to_string(ntohs(addr.sin_port)), error));
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    std::string payload = "one\ntwo";
+    CHECK(sendto(fd, payload.data(), payload.size(), 0,
+                 reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) ==
+          static_cast<ssize_t>(payload.size()));
+
+    std::vector<std::string> lines;
+    pump(mux, lines, 2);
+    CHECK(lines.size() == 2);
+    CHECK(lines[0] == "one");
+    CHECK(lines[1] == "two");
+    close(fd);
+}
+
+void test_listener_refuses_to_replace_non_socket() {
+    std::string path = temp_path("fifo");
+    unlink(path.c_str());
+    CHECK(mkfifo(path.c_str(), 0600) == 0);
+
+    iot_edge::InputMux mux;
+    CHECK(!mux.add_unix_listener(path));
+    CHECK(errno == EEXIST);
+
+    struct stat st{};
+    CHECK(lstat(path.c_str(), &st) == 0);
+    CHECK(S_ISFIFO(st.st_mode));
+    unlink(path.c_str());
+}
+
+void test_fifo_survives_producer_restart() {
+    std::string path = temp_path("input.fifo");
+    unlink(path.c_str());
+    CHECK(mkfifo(path.c_str(), 0600) == 0);
+
+    iot_edge::InputMux mux;
+    std::string error;
+    CHECK(mux.add_sources("fifo:" + path, error));
+
+    // Two producers one after the other, like a restarted simulator. The
+    // mux's own write end must keep the first close from looking like EOF.
+    std::vector<std::string> lines;
+    for (const char* line : {"first\n", "second\n"}) {
+        int fd = open(path.c_str(), O_WRONLY);
+        CHECK(fd >= 0);
+        send_all(fd, line);
+        close(fd);
+        pump(mux, lines, lines.size() + 1);
+    }
+
+    CHECK(lines.size() == 2);
+    CHECK(lines[0] == "first");
+    CHECK(lines[1] == "second");
+    CHECK(mux.source_count() == 1);
+    CHECK(mux.poll(10, [](const std::string&) {}));
+    unlink(path.c_str());
+}
+
+/// Run `body` with stdin replaced by `path`, then restore it.
+template <typename Body>
+void with_stdin(const std::string& path, Body body) {
+    int saved = dup(STDIN_FILENO);
+    int fd = open(path.c_str(), O_RDONLY);
+    CHECK(saved >= 0 && fd >= 0);
+    CHECK(dup2(fd, STDIN_FILENO) == STDIN_FILENO);
+    close(fd);
+    body();
+    CHECK(dup2(saved, STDIN_FILENO) == STDIN_FILENO);
+    close(saved);
+}
+
+void test_stdin_regular_file() {
+    // epoll refuses regular files (EPERM), as with `data_filter < file`.
+    std::string path = temp_path("stdin.jsonl");
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    CHECK(fd >= 0);
+    send_all(fd, "one\ntwo\nthree");
+    close(fd);
+
+    with_stdin(path, [] {
+        iot_edge::InputMux mux;
+        std::string error;
+        CHECK(mux.add_sources("stdin", error));
+
+        std::vector<std::string> lines;
+        auto collect = [&lines](const std::string& line) { lines.push_back(line); };
+        while (mux.poll(1000, collect)) {}
+
+        CHECK(lines.size() == 3);
+        CHECK(lines[0] == "one");
+        CHECK(lines[2] == "three");
+        CHECK(mux.source_count() == 0);
+    });
+    unlink(path.c_str());
+}
+
+void test_stdin_dev_null() {
+    with_stdin("/dev/null", [] {
+        iot_edge::InputMux mux;
+        CHECK(mux.add_stdin());
+
+        auto start = std::chrono::steady_clock::now();
+        bool open = true;
+        for (int i = 0; i < 5 && open; ++i) {
+            open = mux.poll(1000, [](const std::string&) { CHECK(false); });
+        }
+        CHECK(!open);
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+    });
+}
+
+void test_listener_backs_off_when_out_of_fds() {
+    std::string path = temp_path("emfile.sock");
+    iot_edge::InputMux mux;
+    CHECK(mux.add_unix_listener(path));
+
+    // Connect first: the client needs an fd too.
+    int client = connect_unix(path);
+
+    rlimit saved{};
+    CHECK(getrlimit(RLIMIT_NOFILE, &saved) == 0);
+    rlimit low = saved;
+    low.rlim_cur = 256;
+    CHECK(setrlimit(RLIMIT_NOFILE, &low) == 0);
+    std::vector<int> fillers;
+    for (int fd; (fd = open("/dev/null", O_RDONLY)) >= 0;) fillers.push_back(fd);
+    CHECK(errno == EMFILE);
+
+    // The pending connection cannot be accepted. A listener left in a
+    // level-triggered epoll would return immediately thousands of times.
+    int calls = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+    while (std::chrono::steady_clock::now() < deadline) {
+        mux.poll(10, [](const std::string&) {});
+        ++calls;
+    }
+    CHECK(calls < 200);
+
+    for (int fd : fillers) close(fd);
+    CHECK(setrlimit(RLIMIT_NOFILE, &saved) == 0);
+
+    std::vector<std::string> lines;
+    send_all(client, "accepted\n");
+    pump(mux, lines, 1);
+    CHECK(lines.size() == 1);
+    CHECK(lines[0] == "accepted");
+    close(client);
+}
+
+void test_invalid_spec_reports_item() {
+    iot_edge::InputMux mux;
+    std::string error;
+    CHECK(!mux.add_sources("tcp:1234", error));
+    CHECK(error.rfind("tcp:1234", 0) == 0);
+}
+
+}  // namespace
+
+int main() {
+    test_unix_connections_are_framed_separately();
+    test_oversized_line_is_dropped();
+    test_trailing_line_delivered_on_disconnect();
+    test_udp_datagram_lines();
+    test_listener_refuses_to_replace_non_socket();
+    test_fifo_survives_producer_restart();
+    test_stdin_regular_file();
+    test_stdin_dev_null();
+    test_listener_backs_off_when_out_of_fds();
+    test_invalid_spec_reports_item();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
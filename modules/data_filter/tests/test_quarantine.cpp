@@ -0,0 +1,225 @@
+// Tests for Quarantine: per-reason counts, interval batching, threshold and
+// shutdown flushes, and readers that stall or go away. A SEQPACKET socket
+// pair keeps write boundaries, so each recv() is exactly one write().
+
+#include "quarantine.h"
+#include "test_check.h"
+
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using iot_edge::Quarantine;
+using iot_edge::RejectReason;
+using namespace std::chrono_literals;
+
+/// Redirects std::cerr into a string for the lifetime of the object.
+class CaptureStderr {
+public:
+    CaptureStderr() : saved_(std::cerr.rdbuf(out_.rdbuf())) {}
+    ~CaptureStderr() { std::cerr.rdbuf(saved_); }
+
+    std::string take() {
+        std::string s = out_.str();
+        out_.str("");
+        return s;
+    }
+
+private:
+    std::ostringstream out_;
+    std::streambuf* saved_;
+};
+
+/// Every write() waiting on `fd`, one entry per write.
+std::vector<std::string> recv_writes(int fd) {
+    std::vector<std::string> writes;
+    std::vector<char> buf(1 << 20);
+    for (;;) {
+        ssize_t n = recv(fd, buf.data(), buf.size(), MSG_DONTWAIT);
+        if (n < 0) break;
+        writes.emplace_back(buf.data(), static_cast<size_t>(n));
+    }
+    return writes;
+}
+
+struct SocketPair {
+    int writer, reader;
+    SocketPair() {
+        int fds[2];
+        CHECK(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+        writer = fds[0];
+        reader = fds[1];
+        // Room for a full kFlushThreshold batch in one message.
+        int size = 1 << 20;
+        setsockopt(writer, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    }
+    ~SocketPair() {
+        close(writer);
+        close(reader);
+    }
+};
+
+void test_counts_per_reason() {
+    CaptureStderr err;
+    auto start = Quarantine::Clock::now();
+    Quarantine q(10s);
+    q.reject(RejectReason::OutOfRange, "");
+    q.reject(RejectReason::OutOfRange, "");
+    q.reject(RejectReason::SpikeDetected, "");
+
+    CHECK(!q.has_output());
+    CHECK(q.total(RejectReason::OutOfRange) == 2);
+    CHECK(q.total(RejectReason::SpikeDetected) == 1);
+    CHECK(q.total(RejectReason::ParseError) == 0);
+
+    q.tick(start + 11s);
+    CHECK(err.take() == "[data_filter] Rejected 3 since last summary: "
+                        "out_of_range=2 spike_detected=1\n");
+
+    // The window resets after a summary; totals do not.
+    q.reject(RejectReason::ParseError, "");
+    q.tick(start + 22s);
+    CHECK(err.take() == "[data_filter] Rejected 1 since last summary: parse_error=1\n");
+    CHECK(q.total(RejectReason::OutOfRange) == 2);
+    CHECK(q.total(RejectReason::ParseError) == 1);
+
+    // Nothing new: no summary line at all.
+    q.tick(start + 33s);
+    CHECK(err.take().empty());
+}
+
+void test_one_write_per_interval() {
+    CaptureStderr err;
+    SocketPair sock;
+    auto start = Quarantine::Clock::now();
+    Quarantine q(10s);
+    q.set_fd(sock.writer);
+
+    for (int i = 0; i < 200; ++i) {
+        q.reject(RejectReason::OutOfRange, "{\"seq\":" + std::to_string(i) + "}");
+        q.tick(start + 1s);
+    }
+    CHECK(recv_writes(sock.reader).empty());
+    CHECK(err.take().empty());
+
+    q.tick(start + 11s);
+    auto writes = recv_writes(sock.reader);
+    CHECK(writes.size() == 1);
+    CHECK(writes[0].rfind("{\"seq\":0}\n{\"seq\":1}\n", 0) == 0);
+    CHECK(writes[0].size() >= 200 * std::string("{\"seq\":0}\n").size());
+    CHECK(err.take().find("out_of_range=200") != std::string::npos);
+}
+
+void test_threshold_flushes_before_interval() {
+    CaptureStderr err;
+    SocketPair sock;
+    auto start = Quarantine::Clock::now();
+    Quarantine q(10s);
+    q.set_fd(sock.writer);
+
+    std::string record(1000, 'x');
+    int rejected = 0;
+    while (recv_writes(sock.reader).empty()) {
+        CHECK(++rejected < 200);
+        q.reject(RejectReason::SpikeDetected, record);
+        q.tick(start + 1s);
+    }
+    // 64 KiB of 1001-byte lines: written as soon as the 66th record lands.
+    CHECK(rejected == 66);
+    CHECK(err.take().empty());
+}
+
+void test_flush_at_shutdown() {
+    CaptureStderr err;
+    SocketPair sock;
+    {
+        Quarantine q(10s);
+        q.set_fd(sock.writer);
+        q.reject(RejectReason::ParseError, "{\"raw\":\"x\"}");
+        q.flush();
+        auto writes = recv_writes(sock.reader);
+        CHECK(writes.size() == 1);
+        CHECK(writes[0] == "{\"raw\":\"x\"}\n");
+        CHECK(err.take().find("parse_error=1") != std::string::npos);
+
+        // The destructor flushes too, for records added after flush().
+        q.reject(RejectReason::ParseError, "{\"raw\":\"y\"}");
+    }
+    auto writes = recv_writes(sock.reader);
+    CHECK(writes.size() == 1);
+    CHECK(writes[0] == "{\"raw\":\"y\"}\n");
+}
+
+void test_closed_reader_disables_records() {
+    CaptureStderr err;
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    close(fds[0]);
+
+    // SIGPIPE keeps its default action here: surviving it is the test.
+    Quarantine q(10s);
+    q.set_fd(fds[1]);
+    q.reject(RejectReason::OutOfRange, "{}");
+    q.flush();
+
+    CHECK(!q.has_output());
+    CHECK(err.take().find("Quarantine reader closed") != std::string::npos);
+
+    q.reject(RejectReason::OutOfRange, "{}");
+    q.flush();
+    CHECK(q.total(RejectReason::OutOfRange) == 2);
+    CHECK(err.take().find("out_of_range=1") != std::string::npos);
+    close(fds[1]);
+}
+
+void test_slow_reader_keeps_whole_lines() {
+    CaptureStderr err;
+    int fds[2];
+    CHECK(pipe2(fds, O_NONBLOCK) == 0);
+    CHECK(fcntl(fds[1], F_SETPIPE_SZ, 4096) >= 0);
+
+    Quarantine q(10s);
+    q.set_fd(fds[1]);
+    std::string record(999, 'a');  // 1000 bytes per line: 4096 cuts the 5th
+    for (int i = 0; i < 10; ++i) q.reject(RejectReason::OutOfRange, record);
+    q.flush();
+    CHECK(err.take().find("dropped 5 records") != std::string::npos);
+
+    // Drain, then the next batch first completes the cut record.
+    std::string got(8192, '\0');
+    ssize_t n = read(fds[0], &got[0], got.size());
+    CHECK(n == 4096);
+    q.reject(RejectReason::OutOfRange, "{}");
+    q.flush();
+    ssize_t m = read(fds[0], &got[n], got.size() - n);
+    CHECK(m > 0);
+    got.resize(static_cast<size_t>(n + m));
+
+    std::string want;
+    for (int i = 0; i < 5; ++i) want += record + "\n";
+    want += "{}\n";
+    CHECK(got == want);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+}  // namespace
+
+int main() {
+    test_counts_per_reason();
+    test_one_write_per_interval();
+    test_threshold_flushes_before_interval();
+    test_flush_at_shutdown();
+    test_closed_reader_disables_records();
+    test_slow_reader_keeps_whole_lines();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,219 @@
+// Tests for ShmRing: wraparound, full-ring blocking, size limits, corrupt
+// segments, reservation and cleanup. Producer and consumer are two mappings
+// of the same segment inside this process.
+
+#include "shm_ring.h"
+#include "test_check.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/statvfs.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using iot_edge::ShmRing;
+using Status = ShmRing::Status;
+using Role = ShmRing::Role;
+
+std::string ring_name(const char* name) {
+    return "/test_shm_ring_" + std::to_string(getpid()) + "_" + name;
+}
+
+bool segment_exists(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    close(fd);
+    return true;
+}
+
+std::string payload(uint64_t seq, size_t size) {
+    std::string out = std::to_string(seq) + ":";
+    while (out.size() < size) out += static_cast<char>('a' + (out.size() + seq) % 26);
+    return out;
+}
+
+void test_wraparound_preserves_messages() {
+    std::string name = ring_name("wrap");
+    ShmRing producer, consumer;
+    CHECK(producer.open(name, 8192, Role::Producer));
+    CHECK(consumer.open(name, 8192, Role::Consumer));
+
+    // Sizes that do not divide the ring force wrap markers at varying offsets.
+    std::string got;
+    uint64_t read_seq = 0;
+    for (uint64_t seq = 0; seq < 5000; ++seq) {
+        CHECK(producer.write(payload(seq, 1 + (seq * 37) % 1500), 0) == Status::Ok);
+        if (seq % 2 == 1) {
+            for (int i = 0; i < 2; ++i, ++read_seq) {
+                CHECK(consumer.read(got, 0) == Status::Ok);
+                CHECK(got == payload(read_seq, 1 + (read_seq * 37) % 1500));
+            }
+        }
+    }
+    CHECK(consumer.read(got, 0) == Status::Timeout);
+}
+
+void test_full_ring_blocks_until_consumer_reads() {
+    std::string name = ring_name("full");
+    ShmRing producer, consumer;
+    CHECK(producer.open(name, 4096, Role::Producer));
+    CHECK(consumer.open(name, 4096, Role::Consumer));
+
+    std::string msg(500, 'x');
+    int written = 0;
+    while (producer.write(msg, 10) == Status::Ok) written++;
+    CHECK(written > 0);
+
+    std::thread drain([&consumer] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::string got;
+        CHECK(consumer.read(got, 0) == Status::Ok);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(producer.write(msg, 2000) == Status::Ok);
+    auto waited = std::chrono::steady_clock::now() - start;
+    drain.join();
+
+    CHECK(waited >= std::chrono::milliseconds(50));
+    CHECK(waited < std::chrono::milliseconds(1500));
+}
+
+void test_size_limits() {
+    std::string name = ring_name("limits");
+    ShmRing ring;
+    CHECK(!ring.open(name, 0, Role::Producer));
+    CHECK(errno == EINVAL);
+    CHECK(!ring.open(name, ShmRing::kMaxCapacity + 1, Role::Producer));
+    CHECK(errno == EINVAL);
+
+    CHECK(ring.open(name, 4096, Role::Producer));
+    CHECK(ring.write(std::string(ring.max_message_bytes() + 1, 'x'), 0) == Status::TooLarge);
+    CHECK(ring.write(std::string(ring.max_message_bytes(), 'x'), 0) == Status::Ok);
+}
+
+void test_corrupt_length_is_rejected() {
+    std::string name = ring_name("corrupt");
+    ShmRing producer, consumer;
+    CHECK(producer.open(name, 4096, Role::Producer));
+    CHECK(consumer.open(name, 4096, Role::Consumer));
+    CHECK(producer.write("hello", 0) == Status::Ok);
+
+    // Overwrite the first record's length in the data area (after the header page).
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    CHECK(fd >= 0);
+    void* mem = mmap(nullptr, 8192, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(mem != MAP_FAILED);
+    uint32_t bogus = 0x7FFFFFFF;
+    std::memcpy(static_cast<unsigned char*>(mem) + 4096, &bogus, sizeof(bogus));
+    munmap(mem, 8192);
+
+    std::string got;
+    CHECK(consumer.read(got, 0) == Status::Corrupt);
+}
+
+void test_concurrent_producer_consumer() {
+    std::string name = ring_name("stress");
+    constexpr uint64_t kMessages = 200000;
+    ShmRing producer, consumer;
+    CHECK(producer.open(name, 8192, Role::Producer));
+    CHECK(consumer.open(name, 8192, Role::Consumer));
+
+    std::thread writer([&producer] {
+        for (uint64_t seq = 0; seq < kMessages; ++seq) {
+            CHECK(producer.write(payload(seq, 16 + seq % 200), 5000) == Status::Ok);
+        }
+    });
+
+    std::string got;
+    for (uint64_t seq = 0; seq < kMessages; ++seq) {
+        CHECK(consumer.read(got, 5000) == Status::Ok);
+        CHECK(got == payload(seq, 16 + seq % 200));
+    }
+    writer.join();
+}
+
+void test_last_detach_unlinks_segment() {
+    std::string name = ring_name("unlink");
+    {
+        ShmRing producer;
+        CHECK(producer.open(name, 4096, Role::Producer));
+        {
+            ShmRing consumer;
+            CHECK(consumer.open(name, 4096, Role::Consumer));
+        }
+        CHECK(segment_exists(name));
+    }
+    CHECK(!segment_exists(name));
+}
+
+void test_crashed_side_does_not_pin_segment() {
+    std::string name = ring_name("crash");
+    {
+        // Never destroyed: the mapping stays and no detach runs, as after a crash.
+        auto* crashed = new ShmRing;
+        CHECK(crashed->open(name, 4096, Role::Producer));
+
+        ShmRing restarted, consumer;
+        CHECK(restarted.open(name, 4096, Role::Producer));
+        CHECK(consumer.open(name, 4096, Role::Consumer));
+    }
+    CHECK(!segment_exists(name));
+}
+
+void test_oversized_ring_fails_up_front() {
+    // Ask for more than /dev/shm can hold; reserving must fail at open
+    // rather than SIGBUS on first touch of an unbacked page.
+    struct statvfs fs{};
+    CHECK(statvfs("/dev/shm", &fs) == 0);
+    uint64_t free_bytes = static_cast<uint64_t>(fs.f_bavail) * fs.f_frsize;
+    if (free_bytes >= ShmRing::kMaxCapacity) {
+        std::cout << "skipped oversized ring check: /dev/shm has "
+                  << (free_bytes >> 20) << " MiB free\n";
+        return;
+    }
+
+    std::string name = ring_name("enospc");
+    ShmRing ring;
+    CHECK(!ring.open(name, ShmRing::kMaxCapacity, Role::Producer));
+    CHECK(errno == ENOSPC);
+    CHECK(!segment_exists(name));
+}
+
+void test_unsized_segment_is_recreated() {
+    // A creator that died between shm_open and sizing it leaves a 0-byte segment.
+    std::string name = ring_name("stale");
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    CHECK(fd >= 0);
+    close(fd);
+
+    ShmRing ring;
+    CHECK(ring.open(name, 4096, Role::Producer));
+    CHECK(ring.capacity() == 4096);
+    CHECK(ring.write("ok", 0) == Status::Ok);
+}
+
+}  // namespace
+
+int main() {
+    test_wraparound_preserves_messages();
+    test_full_ring_blocks_until_consumer_reads();
+    test_size_limits();
+    test_corrupt_length_is_rejected();
+    test_concurrent_producer_consumer();
+    test_last_detach_unlinks_segment();
+    test_crashed_side_does_not_pin_segment();
+    test_oversized_ring_fails_up_front();
+    test_unsized_segment_is_recreated();
+    std::cout << "All tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace iot_edge {
+
+/// Single-producer/single-consumer message ring in POSIX shared memory.
+/// Replaces the stdout -> FIFO -> stdin hop between co-located modules:
+/// one copy into the segment, one copy out, and no syscalls unless a side
+/// is idle and parks on a futex.
+///
+/// Kept identical in sensor_simulator and data_filter, since each module
+/// builds from its own Docker context; data_filter's tests fail if the two
+/// copies differ.
+class ShmRing {
+public:
+    enum class Status {
+        Ok,
+        Timeout,    // nothing to read / no space within the timeout
+        TooLarge,   // message can never fit; retrying will not help
+        Corrupt,    // record header points outside the ring, or ring not open
+    };
+
+    enum class Role { Producer, Consumer };
+
+    /// Largest accepted data area; larger requests fail with EINVAL.
+    static constexpr size_t kMaxCapacity = size_t{256} << 20;
+
+    ShmRing() = default;
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    /// Create the segment `name` (e.g. "/sensor-to-filter") or attach to an
+    /// existing one as `role`. Either side may start first. `capacity`
+    /// (1..kMaxCapacity) is rounded up to a power of two and only used when
+    /// creating; the pages are reserved up front, so a ring larger than the
+    /// free space in /dev/shm fails with ENOSPC instead of faulting later.
+    /// A segment left unsized or uninitialized by a crashed creator is
+    /// recreated. Returns false with errno set.
+    bool open(const std::string& name, size_t capacity, Role role);
+
+    /// Producer: append one message, waiting up to `timeout_ms` for space.
+    Status write(const std::string& msg, int timeout_ms);
+
+    /// Consumer: pop one message into `out`, waiting up to `timeout_ms`.
+    Status read(std::string& out, int timeout_ms);
+
+    size_t capacity() const { return capacity_; }
+
+    /// Largest payload `write` accepts for this ring.
+    size_t max_message_bytes() const;
+
+private:
+    struct Header;
+
+    std::string name_;
+    Header* header_ = nullptr;
+    unsigned char* data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mapped_bytes_ = 0;
+    Role role_ = Role::Producer;
+
+    enum class Attach { Ok, Failed, Stale };
+    Attach try_open(size_t capacity);
+};
+
+}  // namespace iot_edge
@@ -1,5 +1,6 @@
 #include "sensor.h"
 #include "message_builder.h"
+#include "shm_ring.h"
 
 #include <iostream>
 #include <thread>
@@ -7,6 +8,8 @@
 #include <csignal>
 #include <cstdlib>
 #include <atomic>
+#include <cerrno>
+#include <cstring>
 
 #ifndef STANDALONE_MODE
 #include "iothub_module_client_ll.h"
@@ -51,6 +54,26 @@ int main() {
     std::cerr << "[sensor_simulator] Starting in STANDALONE mode\n";
     std::cerr << "[sensor_simulator] Sensor ID: " << sensor_id << "\n";
     std::cerr << "[sensor_simulator] Interval: " << interval_ms << " ms\n";
+
+    // SHM_RING_NAME swaps stdout for a shared-memory ring read by data_filter
+    std::string ring_name = get_env_str("SHM_RING_NAME", "");
+    iot_edge::ShmRing ring;
+    if (!ring_name.empty()) {
+        int ring_bytes = get_env_int("SHM_RING_BYTES", 1 << 20);
+        if (ring_bytes <= 0 || static_cast<size_t>(ring_bytes) > iot_edge::ShmRing::kMaxCapacity) {
+            std::cerr << "[sensor_simulator] ERROR: SHM_RING_BYTES must be in [1, "
+                      << iot_edge::ShmRing::kMaxCapacity << "]\n";
+            return 1;
+        }
+        if (!ring.open(ring_name, static_cast<size_t>(ring_bytes),
+                       iot_edge::ShmRing::Role::Producer)) {
+            std::cerr << "[sensor_simulator] ERROR: Could not open shared-memory ring "
+                      << ring_name << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        std::cerr << "[sensor_simulator] Output: shm " << ring_name
+                  << " (" << ring.capacity() << " bytes)\n";
+    }
     std::cerr << "---\n";
 
     iot_edge::TemperatureSensor sensor(sensor_id);
@@ -59,8 +82,22 @@ int main() {
         auto reading = sensor.read();
         auto msg = iot_edge::MessageBuilder::build(reading);
 
-        // In standalone mode, write JSON to stdout (can be piped to data_filter)
-        std::cout << msg.body << std::endl;
+        if (!ring_name.empty()) {
+            // Block like a full pipe would, but keep honoring shutdown
+            auto status = iot_edge::ShmRing::Status::Timeout;
+            while (g_running && status == iot_edge::ShmRing::Status::Timeout) {
+                status = ring.write(msg.body, 500);
+            }
+            if (status == iot_edge::ShmRing::Status::TooLarge) {
+                std::cerr << "[sensor_simulator] ERROR: " << msg.body.size()
+                          << "-byte message exceeds ring limit of " << ring.max_message_bytes()
+                          << " bytes; raise SHM_RING_BYTES\n";
+                return 1;
+            }
+        } else {
+            // In standalone mode, write JSON to stdout (can be piped to data_filter)
+            std::cout << msg.body << std::endl;
+        }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
     }